@@ -24,6 +24,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "BacktrackSolver.h"
+#include "Profiler.h"
+#include "SudokuTables.h"
 
 BacktrackSolver::BacktrackSolver() {
 
@@ -38,8 +40,12 @@ bool BacktrackSolver::solve(std::shared_ptr<SudokuProblem> p)
 	unsigned int row, col;
 	this->_p = p;
 
-	if (!_p->get_unassigned(row, col))
-		return true;
+	{
+		// picking the next cell to branch on
+		SUDOKER_PROFILE_SCOPE(BRANCH);
+		if (!_p->get_unassigned(row, col))
+			return true;
+	}
 
 	for (int digit = 1; digit < 10; digit++) {
 		if (try_assign(row, col, digit)) {
@@ -57,11 +63,15 @@ bool BacktrackSolver::solve(std::shared_ptr<SudokuProblem> p)
 }
 
 bool BacktrackSolver::try_assign(unsigned int row, unsigned int col, int val) const {
-	unsigned int blockRowStart = (row - row % SudokuProblem::BLOCK_ROWS);
-	unsigned int blockColStart = (col - col % SudokuProblem::BLOCK_COLS);
+	SUDOKER_PROFILE_SCOPE(PROPAGATE);
+
+	const unsigned int cell = row * SudokuProblem::GRID_SIZE + col;
 
-	return (is_unique(_p->get_row(row), val)
-			&& is_unique(_p->get_col(col), val)
-			&& is_unique(_p->get_block(blockRowStart, blockColStart), val));
+	// the row, column and block of the element are exactly its peers
+	for (int i = 0; i < SudokuTables::NUM_PEERS; i++) {
+		if (_p->get_cell(LOOKUP.cell_peers[cell][i]) == val)
+			return false;
+	}
+	return true;
 }
 
@@ -0,0 +1,606 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "DifficultyRater.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int N = SudokuProblem::GRID_SIZE;
+
+const uint16_t ALL_DIGITS = SudokuTables::NUM_MASKS - 1;
+
+const char* const TECHNIQUE_NAMES[DifficultyRater::NUM_TECHNIQUES] = {
+	"none",
+	"hidden single",
+	"naked single",
+	"locked candidates",
+	"naked pair",
+	"hidden pair",
+	"naked triple",
+	"hidden triple",
+	"x-wing",
+	"swordfish",
+	"naked quad",
+	"hidden quad",
+	"jellyfish",
+	"backtracking"
+};
+
+const unsigned int TECHNIQUE_COSTS[DifficultyRater::NUM_TECHNIQUES] = {
+	0, 1, 2, 5, 10, 12, 16, 20, 25, 35, 40, 45, 50, 100
+};
+
+/** number of problems a rating thread takes from a job at once */
+const size_t CATALOG_BATCH = 256;
+
+/** the most threads rate_catalog() starts per hardware thread */
+const unsigned int THREADS_PER_CORE = 4;
+
+/** number of problems read from the catalog before rating them */
+const size_t CATALOG_CHUNK = 1 << 16;
+
+inline uint16_t digit_bit(int digit) {
+	return 1 << (digit - 1);
+}
+
+inline bool in_unit(int unit, int cell) {
+	if (unit < SudokuTables::COL_UNITS)
+		return LOOKUP.cell_row[cell] == unit;
+	if (unit < SudokuTables::BLOCK_UNITS)
+		return LOOKUP.cell_col[cell] == unit - SudokuTables::COL_UNITS;
+	return LOOKUP.cell_block[cell] == unit - SudokuTables::BLOCK_UNITS;
+}
+
+/**
+ * A fixed set of threads, each with its own rater, that work through the
+ * problems of a job in batches. The threads live as long as the pool, so
+ * the caller is free to do I/O while they rate.
+ */
+class RatingPool {
+	public:
+		/** rates problem i of a job with the rater of the calling thread */
+		typedef std::function<void(DifficultyRater&, size_t)> Job;
+
+		explicit RatingPool(unsigned int threads)
+		 : _size(0), _generation(0), _busy(0), _stop(false), _next(0) {
+			for (unsigned int t = 0; t < threads; t++)
+				_threads.push_back(std::thread(&RatingPool::work, this));
+		}
+
+		~RatingPool() {
+			{
+				std::lock_guard<std::mutex> guard(_lock);
+				_stop = true;
+			}
+			_wake.notify_all();
+			for (size_t t = 0; t < _threads.size(); t++)
+				_threads[t].join();
+		}
+
+		/** hand problems 0 .. n-1 of a job to the threads and return */
+		void start(size_t n, const Job& job) {
+			{
+				std::lock_guard<std::mutex> guard(_lock);
+				_job = job;
+				_size = n;
+				_next = 0;
+				_busy = _threads.size();
+				_generation++;
+			}
+			_wake.notify_all();
+		}
+
+		/** wait until the threads are done with the started job */
+		void wait() {
+			std::unique_lock<std::mutex> guard(_lock);
+			_done.wait(guard, [this]() { return _busy == 0; });
+		}
+
+	private:
+		void work() {
+			DifficultyRater rater;
+			unsigned long seen = 0;
+			for (;;) {
+				std::unique_lock<std::mutex> guard(_lock);
+				_wake.wait(guard, [&]() { return _stop || _generation != seen; });
+				if (_stop)
+					return;
+				seen = _generation;
+				guard.unlock();
+
+				// the job is not changed before every thread is done with it
+				size_t begin;
+				while ((begin = _next.fetch_add(CATALOG_BATCH)) < _size) {
+					const size_t end = std::min(begin + CATALOG_BATCH, _size);
+					for (size_t i = begin; i < end; i++)
+						_job(rater, i);
+				}
+
+				guard.lock();
+				if (--_busy == 0)
+					_done.notify_all();
+			}
+		}
+
+	private:
+		std::vector<std::thread> _threads;
+		std::mutex _lock;
+		std::condition_variable _wake;
+		std::condition_variable _done;
+
+		/** the current job and its number of problems */
+		Job _job;
+		size_t _size;
+
+		/** incremented by every start() */
+		unsigned long _generation;
+
+		/** number of threads still working on the current job */
+		size_t _busy;
+
+		bool _stop;
+
+		/** the first problem of the current job not yet taken */
+		std::atomic<size_t> _next;
+};
+
+/**
+ * Look for k of the N masks whose union has exactly k bits set, and call
+ * fn(members, union) on each such set until it returns true. members has
+ * bit i set for every chosen masks[i].
+ */
+template<typename Fn>
+bool find_subset(const uint16_t (&masks)[N], int k, Fn& fn,
+                 int start = 0, int depth = 0, uint16_t members = 0, uint16_t uni = 0) {
+	if (depth == k)
+		return LOOKUP.mask_count[uni] == k && fn(members, uni);
+
+	for (int i = start; i <= N - (k - depth); i++) {
+		if (!masks[i])
+			continue;
+		const uint16_t u = uni | masks[i];
+		if (LOOKUP.mask_count[u] > k)
+			continue;
+		if (find_subset(masks, k, fn, i + 1, depth + 1, members | (1 << i), u))
+			return true;
+	}
+	return false;
+}
+
+}
+
+DifficultyRater::DifficultyRater()
+ : _unsolved(0) {
+
+}
+
+DifficultyRater::~DifficultyRater() {
+
+}
+
+bool DifficultyRater::solve(std::shared_ptr<SudokuProblem> p) {
+	try {
+		return rate(p).solved;
+	} catch (SudokuException&) {
+		// the problem contradicts itself, report it unsolved like BacktrackSolver
+		return false;
+	}
+}
+
+DifficultyRater::Rating DifficultyRater::rate(std::shared_ptr<SudokuProblem> p) throw (SudokuException) {
+	if (p.get() == NULL)
+		throw SudokuException("no problem to rate");
+	this->_p = p;
+
+	unsigned char grid[SudokuTables::NUM_CELLS];
+	for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++)
+		grid[cell] = _p->get(LOOKUP.cell_row[cell], LOOKUP.cell_col[cell]);
+
+	load(grid);
+	Rating r = run();
+
+	for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++)
+		_p->set(LOOKUP.cell_row[cell], LOOKUP.cell_col[cell], _value[cell]);
+	return r;
+}
+
+DifficultyRater::Rating DifficultyRater::rate(const std::string& line) throw (SudokuException) {
+	unsigned char grid[SudokuTables::NUM_CELLS];
+	parse(line, grid);
+	return rate(grid);
+}
+
+DifficultyRater::Rating DifficultyRater::rate(const unsigned char (&grid)[SudokuTables::NUM_CELLS]) throw (SudokuException) {
+	load(grid);
+	return run();
+}
+
+void DifficultyRater::parse(const std::string& line, unsigned char (&grid)[SudokuTables::NUM_CELLS]) throw (SudokuException) {
+	if (line.size() != SudokuTables::NUM_CELLS)
+		throw SudokuException("Invalid sudoku problem: line length is not "
+		                      + std::to_string(SudokuTables::NUM_CELLS));
+
+	for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++) {
+		const char c = line[cell];
+		if (c == '.')
+			grid[cell] = SudokuProblem::UNASSIGNED;
+		else if (isdigit(c))
+			grid[cell] = c - '0';
+		else
+			throw SudokuException("Invalid sudoku problem: contains non-digit element");
+	}
+}
+
+bool DifficultyRater::read_problem(std::istream& in, std::string& line) {
+	while (getline(in, line)) {
+		if (!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+		if (!line.empty() && line[0] != '#')
+			return true;
+	}
+	return false;
+}
+
+void DifficultyRater::load(const unsigned char (&grid)[SudokuTables::NUM_CELLS]) throw (SudokuException) {
+	for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++) {
+		_cand[cell] = ALL_DIGITS;
+		_value[cell] = SudokuProblem::UNASSIGNED;
+	}
+	_unsolved = SudokuTables::NUM_CELLS;
+
+	for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++)
+		if (grid[cell] != SudokuProblem::UNASSIGNED)
+			assign(cell, grid[cell]);
+}
+
+DifficultyRater::Rating DifficultyRater::run() throw (SudokuException) {
+	Rating r = { NONE, 0, false };
+
+	while (_unsolved) {
+		Technique t;
+		int applied;
+
+		if ((applied = hidden_singles()))
+			t = HIDDEN_SINGLE;
+		else if ((applied = naked_singles()))
+			t = NAKED_SINGLE;
+		else {
+			applied = 1;
+			if (locked_candidates())
+				t = LOCKED_CANDIDATES;
+			else if (naked_subset(2))
+				t = NAKED_PAIR;
+			else if (hidden_subset(2))
+				t = HIDDEN_PAIR;
+			else if (naked_subset(3))
+				t = NAKED_TRIPLE;
+			else if (hidden_subset(3))
+				t = HIDDEN_TRIPLE;
+			else if (fish(2))
+				t = X_WING;
+			else if (fish(3))
+				t = SWORDFISH;
+			else if (naked_subset(4))
+				t = NAKED_QUAD;
+			else if (hidden_subset(4))
+				t = HIDDEN_QUAD;
+			else if (fish(4))
+				t = JELLYFISH;
+			else
+				t = BACKTRACKING;
+		}
+
+		if (t > r.hardest)
+			r.hardest = t;
+		r.score += applied * TECHNIQUE_COSTS[t];
+
+		if (t == BACKTRACKING)
+			return r;
+	}
+
+	r.solved = true;
+	return r;
+}
+
+void DifficultyRater::assign(int cell, int digit) throw (SudokuException) {
+	const uint16_t bit = digit_bit(digit);
+	if (!(_cand[cell] & bit))
+		throw SudokuException("Invalid sudoku problem: "
+		                      + std::to_string(digit) + " cannot be placed at row "
+		                      + std::to_string(LOOKUP.cell_row[cell] + 1) + ", column "
+		                      + std::to_string(LOOKUP.cell_col[cell] + 1));
+
+	_value[cell] = digit;
+	_cand[cell] = 0;
+	_unsolved--;
+	for (int i = 0; i < SudokuTables::NUM_PEERS; i++)
+		_cand[LOOKUP.cell_peers[cell][i]] &= ~bit;
+}
+
+bool DifficultyRater::eliminate(int cell, uint16_t mask) {
+	if (!(_cand[cell] & mask))
+		return false;
+	_cand[cell] &= ~mask;
+	return true;
+}
+
+int DifficultyRater::hidden_singles() throw (SudokuException) {
+	int placed = 0;
+	for (int u = 0; u < SudokuTables::NUM_UNITS; u++) {
+		const unsigned char* cells = LOOKUP.unit_cells[u];
+		uint16_t once = 0, more = 0, solved = 0;
+		for (int i = 0; i < N; i++) {
+			more |= once & _cand[cells[i]];
+			once |= _cand[cells[i]];
+			if (_value[cells[i]] != SudokuProblem::UNASSIGNED)
+				solved |= digit_bit(_value[cells[i]]);
+		}
+		if ((once | solved) != ALL_DIGITS)
+			throw SudokuException("Invalid sudoku problem: a digit has no place left");
+
+		const uint16_t singles = once & ~more;
+		for (int k = 0; k < LOOKUP.mask_count[singles]; k++) {
+			const int digit = LOOKUP.mask_digits[singles][k];
+			for (int i = 0; i < N; i++) {
+				if (_cand[cells[i]] & digit_bit(digit)) {
+					assign(cells[i], digit);
+					placed++;
+					break;
+				}
+			}
+		}
+	}
+	return placed;
+}
+
+int DifficultyRater::naked_singles() throw (SudokuException) {
+	int placed = 0;
+	for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++) {
+		if (_value[cell] != SudokuProblem::UNASSIGNED)
+			continue;
+		if (!_cand[cell])
+			throw SudokuException("Invalid sudoku problem: a cell has no candidate left");
+		if (LOOKUP.mask_count[_cand[cell]] == 1) {
+			assign(cell, LOOKUP.mask_digits[_cand[cell]][0]);
+			placed++;
+		}
+	}
+	return placed;
+}
+
+bool DifficultyRater::locked_candidates() {
+	for (int u = 0; u < SudokuTables::NUM_UNITS; u++) {
+		const unsigned char* cells = LOOKUP.unit_cells[u];
+		for (int digit = 1; digit <= N; digit++) {
+			const uint16_t bit = digit_bit(digit);
+			uint16_t rows = 0, cols = 0, blocks = 0;
+			for (int i = 0; i < N; i++) {
+				if (_cand[cells[i]] & bit) {
+					rows |= 1 << LOOKUP.cell_row[cells[i]];
+					cols |= 1 << LOOKUP.cell_col[cells[i]];
+					blocks |= 1 << LOOKUP.cell_block[cells[i]];
+				}
+			}
+			if (!rows)
+				continue;
+
+			// pointing: the digit of a block is confined to a row or column,
+			// claiming: the digit of a row or column is confined to a block
+			int target = -1;
+			if (u >= SudokuTables::BLOCK_UNITS) {
+				if (LOOKUP.mask_count[rows] == 1)
+					target = LOOKUP.mask_digits[rows][0] - 1;
+				else if (LOOKUP.mask_count[cols] == 1)
+					target = SudokuTables::COL_UNITS + LOOKUP.mask_digits[cols][0] - 1;
+			} else if (LOOKUP.mask_count[blocks] == 1) {
+				target = SudokuTables::BLOCK_UNITS + LOOKUP.mask_digits[blocks][0] - 1;
+			}
+			if (target < 0)
+				continue;
+
+			bool progress = false;
+			for (int i = 0; i < N; i++) {
+				const int cell = LOOKUP.unit_cells[target][i];
+				if (!in_unit(u, cell))
+					progress |= eliminate(cell, bit);
+			}
+			if (progress)
+				return true;
+		}
+	}
+	return false;
+}
+
+bool DifficultyRater::naked_subset(int k) {
+	for (int u = 0; u < SudokuTables::NUM_UNITS; u++) {
+		const unsigned char* cells = LOOKUP.unit_cells[u];
+		uint16_t masks[N];
+		for (int i = 0; i < N; i++)
+			masks[i] = _cand[cells[i]];
+
+		// k cells of the unit that share k candidates between them,
+		// hence those digits go nowhere else in the unit
+		auto apply = [&](uint16_t members, uint16_t digits) {
+			bool progress = false;
+			for (int i = 0; i < N; i++)
+				if (!(members & (1 << i)))
+					progress |= eliminate(cells[i], digits);
+			return progress;
+		};
+		if (find_subset(masks, k, apply))
+			return true;
+	}
+	return false;
+}
+
+bool DifficultyRater::hidden_subset(int k) {
+	for (int u = 0; u < SudokuTables::NUM_UNITS; u++) {
+		const unsigned char* cells = LOOKUP.unit_cells[u];
+		uint16_t positions[N] = {};
+		for (int i = 0; i < N; i++)
+			for (int d = 0; d < N; d++)
+				if (_cand[cells[i]] & (1 << d))
+					positions[d] |= 1 << i;
+
+		// k digits of the unit confined to k cells, hence those cells
+		// cannot hold any other digit
+		auto apply = [&](uint16_t digits, uint16_t slots) {
+			bool progress = false;
+			for (int i = 0; i < N; i++)
+				if (slots & (1 << i))
+					progress |= eliminate(cells[i], ALL_DIGITS & ~digits);
+			return progress;
+		};
+		if (find_subset(positions, k, apply))
+			return true;
+	}
+	return false;
+}
+
+bool DifficultyRater::fish(int k) {
+	for (int digit = 1; digit <= N; digit++) {
+		const uint16_t bit = digit_bit(digit);
+
+		// base sets are the rows then the columns, cover sets the other one
+		for (int transposed = 0; transposed < 2; transposed++) {
+			uint16_t masks[N] = {};
+			for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++) {
+				if (_cand[cell] & bit) {
+					const int base = transposed ? LOOKUP.cell_col[cell] : LOOKUP.cell_row[cell];
+					const int cover = transposed ? LOOKUP.cell_row[cell] : LOOKUP.cell_col[cell];
+					masks[base] |= 1 << cover;
+				}
+			}
+
+			// the digit of k base lines is confined to k cover lines, hence
+			// it is removed from the rest of the cover lines
+			auto apply = [&](uint16_t bases, uint16_t covers) {
+				bool progress = false;
+				for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++) {
+					const int base = transposed ? LOOKUP.cell_col[cell] : LOOKUP.cell_row[cell];
+					const int cover = transposed ? LOOKUP.cell_row[cell] : LOOKUP.cell_col[cell];
+					if ((covers & (1 << cover)) && !(bases & (1 << base)))
+						progress |= eliminate(cell, bit);
+				}
+				return progress;
+			};
+			if (find_subset(masks, k, apply))
+				return true;
+		}
+	}
+	return false;
+}
+
+unsigned long DifficultyRater::rate_catalog(std::istream& in, std::ostream& out, unsigned int threads) {
+	if (threads == 0)
+		threads = 1;
+	if (threads > max_threads())
+		threads = max_threads();
+
+	// while the pool rates a chunk of the catalog, the next one is read and
+	// the ratings of the previous one are written
+	RatingPool pool(threads);
+	std::vector<std::string> problems[2];
+	std::vector<std::string> ratings[2];
+	unsigned long rated = 0;
+	std::string line;
+
+	auto read_chunk = [&](int c) {
+		problems[c].clear();
+		while (problems[c].size() < CATALOG_CHUNK && read_problem(in, line))
+			problems[c].push_back(line);
+		ratings[c].resize(problems[c].size());
+	};
+	auto start_chunk = [&](int c) {
+		pool.start(problems[c].size(), [&problems, &ratings, c](DifficultyRater& rater, size_t i) {
+			try {
+				Rating r = rater.rate(problems[c][i]);
+				ratings[c][i] = problems[c][i] + "," + TECHNIQUE_NAMES[r.hardest]
+				                + "," + std::to_string(r.score);
+			} catch (SudokuException&) {
+				ratings[c][i] = problems[c][i] + ",invalid,0";
+			}
+		});
+	};
+
+	int current = 0;
+	read_chunk(current);
+	start_chunk(current);
+	while (!problems[current].empty()) {
+		const int following = 1 - current;
+		read_chunk(following);
+		pool.wait();
+		if (!problems[following].empty())
+			start_chunk(following);
+
+		for (size_t i = 0; i < ratings[current].size(); i++)
+			out << ratings[current][i] << '\n';
+		rated += problems[current].size();
+		current = following;
+	}
+	out.flush();
+	return rated;
+}
+
+void DifficultyRater::rate_batch(const std::vector<Grid>& grids, std::vector<Rating>& ratings, unsigned int threads) {
+	if (threads == 0)
+		threads = 1;
+	if (threads > max_threads())
+		threads = max_threads();
+
+	ratings.resize(grids.size());
+	RatingPool pool(threads);
+	pool.start(grids.size(), [&grids, &ratings](DifficultyRater& rater, size_t i) {
+		try {
+			ratings[i] = rater.rate(grids[i].cells);
+		} catch (SudokuException&) {
+			Rating invalid = { NONE, 0, false };
+			ratings[i] = invalid;
+		}
+	});
+	pool.wait();
+}
+
+unsigned int DifficultyRater::max_threads() {
+	// hardware_concurrency() returns 0 when it cannot tell
+	return THREADS_PER_CORE * std::max(1u, std::thread::hardware_concurrency());
+}
+
+const char* DifficultyRater::technique_name(Technique t) {
+	return TECHNIQUE_NAMES[t];
+}
+
+unsigned int DifficultyRater::technique_cost(Technique t) {
+	return TECHNIQUE_COSTS[t];
+}
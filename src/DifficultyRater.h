@@ -0,0 +1,232 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __DIFFICULTYRATER_H__
+#define __DIFFICULTYRATER_H__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "SudokuSolver.h"
+#include "SudokuTables.h"
+
+/**
+ * Rates the difficulty of a Sudoku problem by solving it with human
+ * techniques. The candidates of every cell are kept as digit masks and at
+ * each step the cheapest technique that makes progress is applied. The
+ * rating is the hardest technique that was needed together with a score,
+ * which is the sum of the costs of all the applied steps.
+ */
+class DifficultyRater : public SudokuSolver {
+
+	public:
+		/** the techniques in increasing order of cost */
+		enum Technique {
+			/** nothing had to be done, the problem was already solved */
+			NONE = 0,
+			HIDDEN_SINGLE,
+			NAKED_SINGLE,
+			LOCKED_CANDIDATES,
+			NAKED_PAIR,
+			HIDDEN_PAIR,
+			NAKED_TRIPLE,
+			HIDDEN_TRIPLE,
+			X_WING,
+			SWORDFISH,
+			NAKED_QUAD,
+			HIDDEN_QUAD,
+			JELLYFISH,
+			/** none of the techniques above made progress, guessing is needed */
+			BACKTRACKING,
+			NUM_TECHNIQUES
+		};
+
+		/** The result of rating a problem */
+		struct Rating {
+			/** the hardest technique applied */
+			Technique hardest;
+
+			/** sum of the costs of the applied steps */
+			unsigned int score;
+
+			/** True if the techniques solved the problem without guessing */
+			bool solved;
+		};
+
+		/** The cells of a parsed problem in row-major order */
+		struct Grid {
+			unsigned char cells[SudokuTables::NUM_CELLS];
+		};
+
+		DifficultyRater();
+
+		virtual ~DifficultyRater();
+
+		/**
+		 * Solve Sudoku problem with the human techniques only. The digits
+		 * that could be deduced are filled in even if the problem
+		 * could not be solved. A problem that contradicts itself is left
+		 * untouched and reported as not solved.
+		 *
+		 * @param p the problem itself
+		 * @return True if successfully solved the problem, False otherwise
+		 */
+		virtual bool solve(std::shared_ptr<SudokuProblem> p);
+
+		/**
+		 * Rate the difficulty of a problem. Like solve(), it fills in the
+		 * deduced digits.
+		 *
+		 * @param p the problem itself
+		 * @return the rating of the problem
+		 */
+		Rating rate(std::shared_ptr<SudokuProblem> p) throw (SudokuException);
+
+		/**
+		 * Rate the difficulty of a problem given on a single line of 81
+		 * characters, where the unknown elements are either 0 or '.'
+		 *
+		 * @param line the problem in row-major order
+		 * @return the rating of the problem
+		 */
+		Rating rate(const std::string& line) throw (SudokuException);
+
+		/**
+		 * Rate the difficulty of a problem given as its cells in row-major
+		 * order, where the unknown elements are UNASSIGNED
+		 *
+		 * @param grid the cells of the problem
+		 * @return the rating of the problem
+		 */
+		Rating rate(const unsigned char (&grid)[SudokuTables::NUM_CELLS]) throw (SudokuException);
+
+		/**
+		 * Parse a problem given on a single line of 81 characters, where
+		 * the unknown elements are either 0 or '.'
+		 *
+		 * @param line the problem in row-major order
+		 * @param grid the cells of the problem in row-major order
+		 */
+		static void parse(const std::string& line, unsigned char (&grid)[SudokuTables::NUM_CELLS]) throw (SudokuException);
+
+		/**
+		 * Read the next problem line of a catalog, skipping empty lines and
+		 * lines starting with '#'
+		 *
+		 * @param in the catalog
+		 * @param line the problem line without its line ending
+		 * @return True if a problem was read, False at the end of the catalog
+		 */
+		static bool read_problem(std::istream& in, std::string& line);
+
+		/**
+		 * Rate every problem of a catalog. The catalog contains a problem
+		 * per line in the format accepted by rate(const std::string&); empty
+		 * lines and lines starting with '#' are skipped, see read_problem(). For each problem
+		 * a "<problem>,<hardest technique>,<score>" line is written, in
+		 * the order of the catalog. Problems that cannot be rated are
+		 * written as "<problem>,invalid,0".
+		 * The threads are kept for the whole catalog, rating a chunk of it
+		 * while the calling thread reads the next one and writes the
+		 * ratings of the previous one.
+		 *
+		 * @param in the catalog
+		 * @param out the stream to write the ratings to
+		 * @param threads number of threads rating the problems, capped at
+		 * max_threads()
+		 * @return the number of rated problems
+		 */
+		static unsigned long rate_catalog(std::istream& in, std::ostream& out, unsigned int threads);
+
+		/**
+		 * Rate parsed problems on a pool of threads, like rate_catalog()
+		 * but without any parsing or I/O. Problems that cannot be rated
+		 * get a rating of NONE with a score of 0 that is not solved.
+		 *
+		 * @param grids the problems
+		 * @param ratings the ratings of the problems, in the same order
+		 * @param threads number of threads rating the problems, capped at
+		 * max_threads()
+		 */
+		static void rate_batch(const std::vector<Grid>& grids, std::vector<Rating>& ratings, unsigned int threads);
+
+		/**
+		 * Get the largest number of threads rate_catalog() and rate_batch() use
+		 *
+		 * @return a small multiple of the number of hardware threads
+		 */
+		static unsigned int max_threads();
+
+		/**
+		 * Get the name of a technique
+		 *
+		 * @param t the technique
+		 * @return name of the technique
+		 */
+		static const char* technique_name(Technique t);
+
+		/**
+		 * Get the cost of a single application of a technique
+		 *
+		 * @param t the technique
+		 * @return the cost
+		 */
+		static unsigned int technique_cost(Technique t);
+
+	private:
+		/** clear the state and place the givens of the problem */
+		void load(const unsigned char (&grid)[SudokuTables::NUM_CELLS]) throw (SudokuException);
+
+		/** run the techniques until the problem is solved or they get stuck */
+		Rating run() throw (SudokuException);
+
+		/** place a digit into a cell and remove it from the candidates of the peers */
+		void assign(int cell, int digit) throw (SudokuException);
+
+		/** remove the digits of a mask from the candidates of a cell */
+		bool eliminate(int cell, uint16_t mask);
+
+		/** the techniques, returning the number of times they were applied */
+		int hidden_singles() throw (SudokuException);
+		int naked_singles() throw (SudokuException);
+		bool locked_candidates();
+		bool naked_subset(int k);
+		bool hidden_subset(int k);
+		bool fish(int k);
+
+	private:
+		/** candidate digit mask of every cell, 0 for the solved ones */
+		uint16_t _cand[SudokuTables::NUM_CELLS];
+
+		/** digit of every cell, UNASSIGNED if not yet solved */
+		unsigned char _value[SudokuTables::NUM_CELLS];
+
+		/** number of unsolved cells */
+		int _unsolved;
+};
+
+#endif /* __DIFFICULTYRATER_H__ */
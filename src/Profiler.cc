@@ -0,0 +1,160 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const char* const STAGE_NAMES[Profiler::NUM_STAGES] = {
+	"parse", "propagate", "branch", "validate", "write"
+};
+
+struct Histogram {
+	uint64_t count;
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+	uint64_t buckets[Profiler::NUM_BUCKETS];
+
+	Histogram()
+	 : count(0), total(0), min(UINT64_MAX), max(0), buckets() {
+	}
+
+	void add(uint64_t ticks) {
+		count++;
+		total += ticks;
+		if (ticks < min) min = ticks;
+		if (ticks > max) max = ticks;
+		// bucket k holds samples in [2^(k-1), 2^k)
+		int k = ticks ? 64 - __builtin_clzll(ticks) : 0;
+		buckets[k < Profiler::NUM_BUCKETS ? k : Profiler::NUM_BUCKETS - 1]++;
+	}
+
+	void merge(const Histogram& h) {
+		count += h.count;
+		total += h.total;
+		if (h.min < min) min = h.min;
+		if (h.max > max) max = h.max;
+		for (int k = 0; k < Profiler::NUM_BUCKETS; k++)
+			buckets[k] += h.buckets[k];
+	}
+
+	/** upper bound of the bucket that contains the q-th quantile */
+	uint64_t quantile(double q) const {
+		uint64_t rank = (uint64_t) (q * count);
+		uint64_t seen = 0;
+		for (int k = 0; k < Profiler::NUM_BUCKETS; k++) {
+			seen += buckets[k];
+			if (seen > rank)
+				return k ? std::min(max, ((uint64_t) 1 << k) - 1) : 0;
+		}
+		return max;
+	}
+};
+
+struct ThreadHistograms {
+	Histogram stages[Profiler::NUM_STAGES];
+};
+
+// the histograms of the threads are owned by the registry, so that they
+// survive their threads and can be merged at exit. it is never freed, as the
+// exit handler may run after the destruction of static objects.
+struct Registry {
+	std::mutex lock;
+	std::vector<std::unique_ptr<ThreadHistograms> > threads;
+};
+
+Registry& registry() {
+	static Registry* r = new Registry;
+	return *r;
+}
+
+ThreadHistograms& local_histograms() {
+	thread_local ThreadHistograms* h = NULL;
+	if (h == NULL) {
+		Registry& r = registry();
+		std::lock_guard<std::mutex> guard(r.lock);
+		r.threads.emplace_back(new ThreadHistograms);
+		h = r.threads.back().get();
+	}
+	return *h;
+}
+
+void dump_stderr() {
+	Profiler::dump(std::cerr);
+}
+
+}
+
+void Profiler::record(Stage s, uint64_t ticks) {
+	local_histograms().stages[s].add(ticks);
+}
+
+void Profiler::dump(std::ostream& out) {
+	Histogram merged[NUM_STAGES];
+	size_t nthreads;
+	{
+		Registry& r = registry();
+		std::lock_guard<std::mutex> guard(r.lock);
+		nthreads = r.threads.size();
+		for (size_t t = 0; t < nthreads; t++)
+			for (int s = 0; s < NUM_STAGES; s++)
+				merged[s].merge(r.threads[t]->stages[s]);
+	}
+
+	out << "profile summary (" << nthreads << " thread(s), ticks per call)" << std::endl
+	    << std::left << std::setw(10) << "stage" << std::right
+	    << std::setw(12) << "calls"
+	    << std::setw(16) << "total"
+	    << std::setw(12) << "mean"
+	    << std::setw(12) << "min"
+	    << std::setw(12) << "p50"
+	    << std::setw(12) << "p99"
+	    << std::setw(12) << "max" << std::endl;
+
+	for (int s = 0; s < NUM_STAGES; s++) {
+		const Histogram& h = merged[s];
+		out << std::left << std::setw(10) << STAGE_NAMES[s] << std::right
+		    << std::setw(12) << h.count
+		    << std::setw(16) << h.total
+		    << std::setw(12) << (h.count ? h.total / h.count : 0)
+		    << std::setw(12) << (h.count ? h.min : 0)
+		    << std::setw(12) << h.quantile(0.50)
+		    << std::setw(12) << h.quantile(0.99)
+		    << std::setw(12) << h.max << std::endl;
+	}
+}
+
+void Profiler::dump_at_exit() {
+	std::atexit(dump_stderr);
+}
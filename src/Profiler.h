@@ -0,0 +1,146 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+/*
+ * Stage probes for the sudoker_profile build. Every macro below expands to
+ * nothing unless SUDOKER_PROFILE is defined, hence the normal sudoker target
+ * carries no trace of the profiler.
+ */
+#ifdef SUDOKER_PROFILE
+
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#ifdef SUDOKER_HAVE_SDT
+#include <sys/sdt.h>
+#endif
+
+/**
+ * Collects per-thread histograms of the time spent in the solver stages.
+ * Samples are timestamp-counter ticks (nanoseconds on non-x86 targets)
+ * bucketed by their base-2 logarithm.
+ */
+class Profiler {
+	public:
+		/** the stages of the solver that are probed */
+		enum Stage {
+			PARSE = 0,
+			PROPAGATE,
+			BRANCH,
+			VALIDATE,
+			WRITE,
+			NUM_STAGES
+		};
+
+		/** number of log2 buckets of a histogram */
+		const static int NUM_BUCKETS = 64;
+
+		/**
+		 * Read the current timestamp
+		 *
+		 * @return TSC value on x86, monotonic nanoseconds otherwise
+		 */
+		static inline uint64_t timestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+		}
+
+		/**
+		 * Add a sample to the calling thread's histogram of a stage
+		 *
+		 * @param s the stage the sample belongs to
+		 * @param ticks the duration of the stage
+		 */
+		static void record(Stage s, uint64_t ticks);
+
+		/**
+		 * Merge the histograms of every thread and write a summary per stage
+		 *
+		 * @param out the stream to write the summary to
+		 */
+		static void dump(std::ostream& out);
+
+		/**
+		 * Register a handler that dumps the summary to stderr at exit
+		 */
+		static void dump_at_exit();
+};
+
+/**
+ * Times the enclosing scope and records it under the given stage.
+ */
+class ScopedTimer {
+	public:
+		explicit ScopedTimer(Profiler::Stage s)
+		 : _stage(s) {
+#ifdef SUDOKER_HAVE_SDT
+			DTRACE_PROBE1(sudoker, stage__begin, (int) _stage);
+#endif
+			_start = Profiler::timestamp();
+		}
+
+		~ScopedTimer() {
+			uint64_t ticks = Profiler::timestamp() - _start;
+#ifdef SUDOKER_HAVE_SDT
+			DTRACE_PROBE2(sudoker, stage__end, (int) _stage, ticks);
+#endif
+			Profiler::record(_stage, ticks);
+		}
+
+	private:
+		ScopedTimer(const ScopedTimer&);
+		ScopedTimer& operator=(const ScopedTimer&);
+
+		/** the stage being timed */
+		Profiler::Stage _stage;
+
+		/** timestamp at the entry of the scope */
+		uint64_t _start;
+};
+
+#define SUDOKER_PROFILE_SCOPE(stage) ScopedTimer _sudoker_scoped_timer(Profiler::stage)
+#define SUDOKER_PROFILE_DUMP_AT_EXIT() Profiler::dump_at_exit()
+
+#else
+
+#define SUDOKER_PROFILE_SCOPE(stage)
+#define SUDOKER_PROFILE_DUMP_AT_EXIT()
+
+#endif /* SUDOKER_PROFILE */
+
+#endif /* __PROFILER_H__ */
@@ -24,6 +24,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "SudokuProblem.h"
+#include "Profiler.h"
 
 #include <iostream>
 #include <fstream>
@@ -50,6 +51,8 @@ SudokuProblem::~SudokuProblem() {
 }
 
 std::shared_ptr<SudokuProblem> SudokuProblem::read_csv(const std::string& fname) throw (SudokuException) {
+	SUDOKER_PROFILE_SCOPE(PARSE);
+
 	// open file
 	std::ifstream sudoku_file(fname.c_str());
 
@@ -109,6 +112,8 @@ std::shared_ptr<SudokuProblem> SudokuProblem::read_csv(const std::string& fname)
 }
 
 void SudokuProblem::save_csv(const std::string& fname) throw (SudokuException) {
+	SUDOKER_PROFILE_SCOPE(WRITE);
+
 	std::ofstream sudoku_file(fname.c_str());
 
 	// check if managed to open
@@ -105,6 +105,18 @@ class SudokuProblem {
 		 */
 		int get(const unsigned int row, const unsigned int col) const throw(SudokuException);
 
+		/**
+		 * Get the element value of a cell without any bound checking,
+		 * for the hot paths of the solvers
+		 *
+		 * @param cell index of the cell in row-major order, below GRID_SIZE * GRID_SIZE
+		 * @return element value
+		 */
+		int get_cell(const unsigned int cell) const {
+			// Eigen stores the grid in column-major order
+			return _m.data()[cell % GRID_SIZE * GRID_SIZE + cell / GRID_SIZE];
+		}
+
 		/**
 		 * Get row of the grid
 		 *
@@ -24,6 +24,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "SudokuSolver.h"
+#include "Profiler.h"
+#include "SudokuTables.h"
 
 
 SudokuSolver::SudokuSolver() {
@@ -34,28 +36,7 @@ SudokuSolver::~SudokuSolver() {
 
 }
 
-#include <iostream>
-
-bool SudokuSolver::is_solved(std::shared_ptr<SudokuProblem> p) {
-	if (p.get() == NULL)
-		return false;
-
-	for (int i = 0; i < SudokuProblem::GRID_SIZE; i++) {
-		if (!is_unique(p->get_row(i)))
-		    return false;
-		if (!is_unique(p->get_col(i)))
-			return false;
-
-		unsigned int blockRowStart = i - i % SudokuProblem::BLOCK_ROWS;
-		unsigned int blockColStart = i % SudokuProblem::BLOCK_COLS * SudokuProblem::BLOCK_COLS;
-
-		if (!is_unique(p->get_block(blockRowStart, blockColStart)))
-		    return false;
-	}
-	return true;
-}
-
-inline bool check_uniqueness(int cur_val, bool (&seen)[10], int val) {
+inline bool check_uniqueness(int cur_val, bool (&seen)[10], int val = SudokuProblem::UNASSIGNED) {
 	// val is given we just want to check if that's equals cur_val
 	if (val != SudokuProblem::UNASSIGNED) {
 		if (cur_val == val)
@@ -77,26 +58,19 @@ inline bool check_uniqueness(int cur_val, bool (&seen)[10], int val) {
 	return true;
 }
 
-template<typename Iterator>
-bool SudokuSolver::is_unique(Iterator& it, int val) {
-	bool seen[] = {false, false, false, false, false,
-				false, false, false, false, false};
-	for (int i = 0; i < it.size(); i++) {
-		if (!check_uniqueness(it[i], seen, val))
-			return false;
-	}
-	return true;
-}
+bool SudokuSolver::is_solved(std::shared_ptr<SudokuProblem> p) {
+	SUDOKER_PROFILE_SCOPE(VALIDATE);
 
-bool SudokuSolver::is_unique(SudokuProblem::ConstBlock& b, int val) {
-	bool seen[] = {false, false, false, false, false,
-				false, false, false, false, false};
-	for (unsigned int i = 0; i < b.cols(); i++) {
-		for (unsigned int j = 0; j < b.rows(); j++) {
-			if (!check_uniqueness(b(i, j), seen, val))
+	if (p.get() == NULL)
+		return false;
+
+	for (int u = 0; u < SudokuTables::NUM_UNITS; u++) {
+		bool seen[] = {false, false, false, false, false,
+					false, false, false, false, false};
+		for (int i = 0; i < SudokuProblem::GRID_SIZE; i++) {
+			if (!check_uniqueness(p->get_cell(LOOKUP.unit_cells[u][i]), seen))
 				return false;
 		}
 	}
 	return true;
 }
-
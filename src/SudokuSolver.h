@@ -54,28 +54,6 @@ class SudokuSolver {
 		 */
 		static bool is_solved(std::shared_ptr<SudokuProblem> p);
 
-	protected:
-		/**
-		 * Checks whether the supplied row or column elements are unique
-		 *
-		 * @param it ConstRowXpr or ConstColXpr pointer
-		 * @param val if set then checks whether adding the given value would
-		 * change uniqueness
-		 * @return True if all elements unique, False otherwise
-		 */
-		template<typename Iterator>
-		static bool is_unique(Iterator& it, int val = SudokuProblem::UNASSIGNED);
-
-		/**
-		 * Checks whether the supplied block elements are unique
-		 *
-		 * @parma b block of the sudoku grid
-		 * @param val if set then checks whether adding the given value would
-		 * change uniqueness
-		 * @return True if all elements are unique, False otherwise
-		 */
-		static bool is_unique(SudokuProblem::ConstBlock& b, int val = SudokuProblem::UNASSIGNED);
-
 	protected:
 		/** pointer to the given problem itself */
 		std::shared_ptr<SudokuProblem> _p;
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "SudokuTables.h"
+
+constexpr SudokuTables SudokuLookup::TABLES;
+
+namespace {
+
+/**
+ * Cross-checks the tables against the plain index arithmetic, so that a
+ * broken table fails the build rather than the solver.
+ */
+constexpr bool check_lookup_tables() {
+	const int N = SudokuProblem::GRID_SIZE;
+	const int BR = SudokuProblem::BLOCK_ROWS;
+	const int BC = SudokuProblem::BLOCK_COLS;
+
+	for (int row = 0; row < N; row++) {
+		for (int col = 0; col < N; col++) {
+			const int cell = row * N + col;
+			const int b = LOOKUP.cell_block[cell];
+			if (LOOKUP.cell_row[cell] != row || LOOKUP.cell_col[cell] != col)
+				return false;
+			if (LOOKUP.block_row_start[b] != row - row % BR
+			    || LOOKUP.block_col_start[b] != col - col % BC)
+				return false;
+
+			int peers = 0;
+			for (int other = 0; other < SudokuTables::NUM_CELLS; other++) {
+				const int r = other / N;
+				const int c = other % N;
+				if (other != cell && (r == row || c == col
+				    || (r - r % BR == row - row % BR && c - c % BC == col - col % BC))) {
+					if (LOOKUP.cell_peers[cell][peers++] != other)
+						return false;
+				}
+			}
+			if (peers != SudokuTables::NUM_PEERS)
+				return false;
+		}
+	}
+
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++) {
+			if (LOOKUP.unit_cells[i][j] != i * N + j
+			    || LOOKUP.unit_cells[SudokuTables::COL_UNITS + i][j] != j * N + i
+			    || LOOKUP.cell_block[LOOKUP.unit_cells[SudokuTables::BLOCK_UNITS + i][j]] != i)
+				return false;
+		}
+	}
+
+	for (int mask = 0; mask < SudokuTables::NUM_MASKS; mask++) {
+		int count = 0;
+		for (int m = mask; m; m &= m - 1)
+			count++;
+		if (LOOKUP.mask_count[mask] != count)
+			return false;
+		for (int k = 0; k < N; k++) {
+			const int d = LOOKUP.mask_digits[mask][k];
+			if ((k < count) != (d != SudokuProblem::UNASSIGNED))
+				return false;
+			if (k < count && (!(mask & (1 << (d - 1)))
+			    || (k && d <= LOOKUP.mask_digits[mask][k - 1])))
+				return false;
+		}
+	}
+	return true;
+}
+
+}
+
+static_assert(check_lookup_tables(), "lookup tables disagree with the grid arithmetic");
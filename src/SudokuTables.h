@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __SUDOKUTABLES_H__
+#define __SUDOKUTABLES_H__
+
+#include "SudokuProblem.h"
+
+/**
+ * Lookup tables of the Sudoku geometry, generated at compile time.
+ *
+ * Cells are indexed row-major (cell = row * GRID_SIZE + col). Units are
+ * indexed as the rows first, then the columns and finally the blocks, which
+ * are numbered row-major as well. Digit masks have bit (d - 1) set for each
+ * candidate digit d.
+ */
+class SudokuTables {
+	public:
+		/** number of cells of the grid */
+		const static int NUM_CELLS = SudokuProblem::GRID_SIZE * SudokuProblem::GRID_SIZE;
+
+		/** number of units, i.e. rows, columns and blocks */
+		const static int NUM_UNITS = 3 * SudokuProblem::GRID_SIZE;
+
+		/** number of cells sharing a unit with a given cell */
+		const static int NUM_PEERS = 2 * (SudokuProblem::GRID_SIZE - 1)
+			+ (SudokuProblem::BLOCK_ROWS - 1) * (SudokuProblem::BLOCK_COLS - 1);
+
+		/** number of distinct digit masks */
+		const static int NUM_MASKS = 1 << SudokuProblem::GRID_SIZE;
+
+		/** index of the first column unit */
+		const static int COL_UNITS = SudokuProblem::GRID_SIZE;
+
+		/** index of the first block unit */
+		const static int BLOCK_UNITS = 2 * SudokuProblem::GRID_SIZE;
+
+		/** row of a cell */
+		unsigned char cell_row[NUM_CELLS];
+
+		/** column of a cell */
+		unsigned char cell_col[NUM_CELLS];
+
+		/** block of a cell */
+		unsigned char cell_block[NUM_CELLS];
+
+		/** the cells sharing a row, column or block with a cell */
+		unsigned char cell_peers[NUM_CELLS][NUM_PEERS];
+
+		/** first row of a block */
+		unsigned char block_row_start[SudokuProblem::GRID_SIZE];
+
+		/** first column of a block */
+		unsigned char block_col_start[SudokuProblem::GRID_SIZE];
+
+		/** the cells of a unit */
+		unsigned char unit_cells[NUM_UNITS][SudokuProblem::GRID_SIZE];
+
+		/** number of digits in a mask */
+		unsigned char mask_count[NUM_MASKS];
+
+		/** the digits of a mask in increasing order, padded with UNASSIGNED */
+		unsigned char mask_digits[NUM_MASKS][SudokuProblem::GRID_SIZE];
+
+		constexpr SudokuTables()
+		 : cell_row(), cell_col(), cell_block(), cell_peers(),
+		   block_row_start(), block_col_start(), unit_cells(),
+		   mask_count(), mask_digits() {
+			const int N = SudokuProblem::GRID_SIZE;
+			const int BR = SudokuProblem::BLOCK_ROWS;
+			const int BC = SudokuProblem::BLOCK_COLS;
+			const int blocks_per_row = N / BC;
+
+			for (int b = 0; b < N; b++) {
+				block_row_start[b] = b / blocks_per_row * BR;
+				block_col_start[b] = b % blocks_per_row * BC;
+			}
+
+			int unit_size[NUM_UNITS] = {};
+			for (int cell = 0; cell < NUM_CELLS; cell++) {
+				const int r = cell / N;
+				const int c = cell % N;
+				const int b = r / BR * blocks_per_row + c / BC;
+				cell_row[cell] = r;
+				cell_col[cell] = c;
+				cell_block[cell] = b;
+				unit_cells[r][unit_size[r]++] = cell;
+				unit_cells[COL_UNITS + c][unit_size[COL_UNITS + c]++] = cell;
+				unit_cells[BLOCK_UNITS + b][unit_size[BLOCK_UNITS + b]++] = cell;
+			}
+
+			for (int cell = 0; cell < NUM_CELLS; cell++) {
+				int n = 0;
+				for (int other = 0; other < NUM_CELLS; other++) {
+					if (other == cell)
+						continue;
+					if (cell_row[other] == cell_row[cell]
+					    || cell_col[other] == cell_col[cell]
+					    || cell_block[other] == cell_block[cell])
+						cell_peers[cell][n++] = other;
+				}
+			}
+
+			for (int mask = 0; mask < NUM_MASKS; mask++) {
+				int n = 0;
+				for (int d = 1; d <= N; d++)
+					if (mask & (1 << (d - 1)))
+						mask_digits[mask][n++] = d;
+				mask_count[mask] = n;
+			}
+		}
+};
+
+/**
+ * Holds the single instance of the lookup tables. Being a constexpr static
+ * member, the tables are compile-time constants in every translation unit,
+ * while SudokuTables.cc provides the one definition they are stored in.
+ */
+class SudokuLookup {
+	public:
+		static constexpr SudokuTables TABLES = SudokuTables();
+};
+
+/** the lookup tables shared by the solvers and validators */
+static constexpr const SudokuTables& LOOKUP = SudokuLookup::TABLES;
+
+#endif /* __SUDOKUTABLES_H__ */
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "SudokuProblem.h"
 #include "BacktrackSolver.h"
+#include "Profiler.h"
 
 int main (int argc, char** argv)
 {
@@ -40,6 +41,9 @@ int main (int argc, char** argv)
 	}
 	const std::string out_fname = argv[2];
 
+	// in the sudoker_profile build print the stage histograms when exiting
+	SUDOKER_PROFILE_DUMP_AT_EXIT();
+
 	SudokuSolver* solver = NULL;
 	try {
 		std::shared_ptr<SudokuProblem> p = SudokuProblem::read_csv(argv[1]);
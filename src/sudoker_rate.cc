@@ -0,0 +1,163 @@
+/*
+Copyright (c) 2014, Viktor Gal
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SudokuProblem.h"
+#include "BacktrackSolver.h"
+#include "DifficultyRater.h"
+
+/**
+ * number of problems the bench solves with backtracking, which can take
+ * seconds per problem
+ */
+static const size_t BENCH_SOLVE_SAMPLE = 10;
+
+static void usage(const std::string& reason) {
+	std::cerr << reason << std::endl
+	<< "Please use one of the following commands:" << std::endl
+	<< "\t./sudoker_rate <catalog file> <ratings file> [threads]" << std::endl
+	<< "\t./sudoker_rate --bench <catalog file> [threads]" << std::endl;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const std::string& what, size_t problems, double seconds) {
+	std::cout << what << ": " << problems << " problems in " << seconds << " seconds, "
+	<< (seconds > 0 ? problems / seconds : 0) << " problems/s" << std::endl;
+}
+
+/**
+ * Compare the throughput of rating the problems of a catalog, on one and
+ * on every thread, with solving them with the backtrack solver. Only the
+ * problems that can be rated take part, and only an evenly spaced sample
+ * of BENCH_SOLVE_SAMPLE of them is solved.
+ */
+static int bench(const std::string& fname, unsigned int threads) {
+	std::ifstream catalog(fname.c_str());
+	if (!catalog.is_open()) {
+		std::cerr << "could not open file " << fname << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// keep the problems that parse and can be rated
+	DifficultyRater rater;
+	std::vector<DifficultyRater::Grid> grids;
+	size_t skipped = 0;
+	std::string line;
+	while (DifficultyRater::read_problem(catalog, line)) {
+		DifficultyRater::Grid g;
+		try {
+			DifficultyRater::parse(line, g.cells);
+			rater.rate(g.cells);
+		} catch (SudokuException&) {
+			skipped++;
+			continue;
+		}
+		grids.push_back(g);
+	}
+	catalog.close();
+
+	// rating on a single thread and on every thread, the same way
+	std::vector<DifficultyRater::Rating> ratings;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	DifficultyRater::rate_batch(grids, ratings, 1);
+	const double rate_time = seconds_since(start);
+	report("rating, 1 thread", grids.size(), rate_time);
+
+	start = std::chrono::steady_clock::now();
+	DifficultyRater::rate_batch(grids, ratings, threads);
+	report("rating, " + std::to_string(threads) + " threads", grids.size(), seconds_since(start));
+
+	// raw solving with backtracking on a single thread, over a sample
+	const size_t sample = std::min(grids.size(), BENCH_SOLVE_SAMPLE);
+	BacktrackSolver solver;
+	start = std::chrono::steady_clock::now();
+	for (size_t k = 0; k < sample; k++) {
+		const DifficultyRater::Grid& g = grids[k * grids.size() / sample];
+		std::shared_ptr<SudokuProblem> p(new SudokuProblem);
+		for (int cell = 0; cell < SudokuTables::NUM_CELLS; cell++)
+			p->set(LOOKUP.cell_row[cell], LOOKUP.cell_col[cell], g.cells[cell]);
+		solver.solve(p);
+	}
+	const double solve_time = seconds_since(start);
+	report("backtracking, 1 thread", sample, solve_time);
+
+	// compare the time per problem, as the sample may be smaller
+	if (sample > 0 && solve_time > 0)
+		std::cout << "rating takes " << (rate_time / grids.size()) / (solve_time / sample)
+		<< "x the time of backtracking" << std::endl;
+	if (skipped)
+		std::cout << skipped << " problems could not be rated and were skipped" << std::endl;
+
+	return EXIT_SUCCESS;
+}
+
+int main (int argc, char** argv)
+{
+	if (argc < 3 || argc > 4) {
+		usage("Invalid number of arguments");
+		return EXIT_FAILURE;
+	}
+
+	unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+	if (argc == 4) {
+		char* end;
+		const long n = strtol(argv[3], &end, 10);
+		if (end == argv[3] || *end != '\0' || n <= 0) {
+			usage("Invalid number of threads: " + std::string(argv[3]));
+			return EXIT_FAILURE;
+		}
+		threads = std::min<long>(n, DifficultyRater::max_threads());
+	}
+
+	if (std::string(argv[1]) == "--bench")
+		return bench(argv[2], threads);
+
+	std::ifstream catalog(argv[1]);
+	if (!catalog.is_open()) {
+		std::cerr << "could not open file " << argv[1] << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::ofstream ratings(argv[2]);
+	if (!ratings.is_open()) {
+		std::cerr << "could not open file " << argv[2] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned long rated = DifficultyRater::rate_catalog(catalog, ratings, threads);
+	report("rated on " + std::to_string(threads) + " threads", rated, seconds_since(start));
+
+	return EXIT_SUCCESS;
+}